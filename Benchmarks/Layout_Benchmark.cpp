@@ -0,0 +1,58 @@
+//
+// Created by aowyn on 10/19/26.
+//
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "../Dungeon_Map/Dungeon_Map.h"
+
+/* CONSTANTS */
+constexpr int SIZES[3] = {1000, 10000, 100000}; //the dungeon sizes each policy is benchmarked at
+constexpr int SEEDS = 5; //the number of seeds each size is generated with
+
+/**
+ * benchmark_policy generates a dungeon of every size in SIZES with SEEDS different seeds using @tparam Growth_Policy
+ * and prints the mean time to generate the layout, the tiles placed per second, the mean time analyze_layout takes and
+ * the mean shape of the layouts as measured by analyze_layout: how far the furthest tile is from the entrance, the
+ * longest path through the dungeon and the share of tiles that are dead ends.
+ * @param name: the name of the policy printed in front of each row
+ */
+template<typename Growth_Policy>
+void benchmark_policy(const std::string &name) {
+    for (const int size : SIZES) {
+        Dungeon_Map map(size);
+        double total_ms = 0, analyze_ms = 0;
+        double max_depth = 0, diameter = 0, dead_ends = 0;
+
+        for (int seed = 0; seed < SEEDS; seed++) {
+            map.reset(size);
+            const auto start = std::chrono::steady_clock::now();
+            map.generate_dungeon_layout<Growth_Policy>(std::mt19937(seed));
+            total_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            const auto analyzed = std::chrono::steady_clock::now();
+            const auto &analytics = map.analyze_layout();
+            analyze_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - analyzed).count();
+            for (const int depth : analytics.depth) {
+                max_depth = std::max<double>(max_depth, depth);
+            }
+            diameter += analytics.diameter;
+            dead_ends += static_cast<double>(analytics.dead_ends.size()) / size;
+        }
+
+        const double mean_ms = total_ms / SEEDS;
+        std::cout << name << " size=" << size << " mean_ms=" << mean_ms << " tiles_per_s=" << size / mean_ms * 1000
+                  << " analyze_ms=" << analyze_ms / SEEDS
+                  << " max_depth=" << max_depth << " mean_diameter=" << diameter / SEEDS
+                  << " dead_end_share=" << dead_ends / SEEDS << std::endl;
+    }
+}
+
+int main() {
+    benchmark_policy<Layout::Uniform_Frontier>("uniform_frontier");
+    benchmark_policy<Layout::Biased_DFS<>>("biased_dfs");
+    benchmark_policy<Layout::Corridor_First<>>("corridor_first");
+    benchmark_policy<Layout::With_Loops<Layout::Uniform_Frontier, 100>>("uniform_frontier+100_loops");
+}
@@ -3,6 +3,7 @@
 //
 #include "Dungeon_Map.h"
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <list>
@@ -32,132 +33,52 @@ Dungeon_Map::Dungeon_Map(const int size) {
 }
 
 /**
- * generate_dungeon_layout utilizes the basic concepts of randomized depth first search to generate a random dungoen layout.
- * the algorithm can be summerized as randomized depth first search over an unbounded plane limited by the number of tiles
- * in @var rooms.
- *
- * the algorithm is as follows:
- *      Create @var map_tiles, an adjacency list of X,Y coordinate pairs;
- *      Create @var unexplored_edges vector of edges that have not been explored;
- *
- *      add the origin(0,0) to map_tiles and all of its direct neighbors to unexplored_edges;
- *      while( the number of rooms to place is greater than 0 ){
- *          Select a random edge in unexplored_edges;
- *          add the target tile of that edge to map_tiles;
- *          add an edge in map_tiles between the two tiles connected by the selected edge;
- *
- *          remove all additional edges from unexplored_edges that go to the target tile;
- *          add all edges of target tile that go to an unadded position to unexplored_edges;
- *          decrement number of rooms to place;
- *      }
- *
- * The algorithm creates very clustered close to circular dungeon layouts in total but maintains two primary principles:
- *      1. the paths through the dungeon are random
- *      2. if graphed as a set of nodes and edges the dungeon forms a tree from the tile at relative position 0,0 as
- *         root. the graph has no cycles or loops.
- *
- * @param random_number_generator: the pre-seeded random number generator used to select random unexplored edges
+ * reset clears @var rooms and @var analytics, dropping every tile, connection and measurement of the previous layout,
+ * and then refills rooms with the specified number of default tiles exactly like the constructor does. Clearing rather
+ * than rebuilding them lets the tile, edge and analytics vectors keep their capacity, so a map that is reused for many
+ * layouts stays warm.
+ * @param size: the number of tiles in the new dungeon
  */
-void Dungeon_Map::generate_dungeon_layout(std::mt19937 random_number_generator) {
-    /**
-     * @struct edge defines an edge from cartesian point origin to cartesian point target. the == operator is overloaded
-     * to allow for comparrison in the adjacency_list get_index_of() function.
-     */
-    struct edge {
-        std::pair<int, int> origin; //the cartesian coordinate of the origin point
-        std::pair<int, int> target; //the cartesian coordinate of the target point
-
-        //overloading the == operator to allow for proper comparison
-        bool operator==(const edge &e) const {
-            if (origin == e.origin && target == e.target) {
-                return true;
-            }
-            return false;
-        }
-    };
-
-    //get number of tiles to place after first
-    int num_tiles = rooms.get_size() - 1;
-
-    //create an adjacency list to store the selected spaces
-    Adjacency_List<std::pair<int, int>> map_tiles;
-    //create a list of edges that are unexplored
-    std::vector<edge> unexplored_edges;
-
-    //define the first space in the area as being at position (zero, zero)
-    std::pair<int, int> root = {0, 0};
-    map_tiles.add_vertex(root);
-
-    //add each edge of root to unexplored_edges
-    std::pair<int, int> temp = {root.first + 1, root.second};
-    edge e = {root, temp};
-    unexplored_edges.push_back(e);
-    temp = {root.first - 1, root.second};
-    e = {root, temp};
-    unexplored_edges.push_back(e);
-    temp = {root.first, root.second + 1};
-    e = {root, temp};
-    unexplored_edges.push_back(e);
-    temp = {root.first, root.second - 1};
-    e = {root, temp};
-    unexplored_edges.push_back(e);
-
-    //while there are still tiles to place
-    while (num_tiles > 0) {
-        //select a random edge in unxplored edges
-        auto [origin, target] = unexplored_edges[random_number_generator() % unexplored_edges.size()];
-        //add the target point to map_tiles
-        map_tiles.add_vertex(target);
-        //add an edge in map_tiles between the origin point and the target point
-        map_tiles.add_edge(map_tiles.get_index_of(origin), map_tiles.get_size() - 1);
-
-        //while there are still edges in unexplored_edges that point to the target point
-        while (
-            std::ranges::find_if(unexplored_edges, [target](const edge& UE){ return UE.target == target;})
-            != unexplored_edges.end()) {
-            //remove those edges from unexplored_edges
-            unexplored_edges.erase(std::ranges::find_if(unexplored_edges, [target](const edge &UE) {
-                return UE.target == target;
-            }));
-        }
-
-        //check the positions in each direction from the target edge and add an edge to unexplored edges from target
-        //edge to that position if it is unoccupied.
-        temp = {target.first + 1, target.second};
-        if (map_tiles.get_index_of(temp) == -1) {
-            e = {target, temp};
-            unexplored_edges.push_back(e);
-        }
-        temp = {target.first - 1, target.second};
-        if (map_tiles.get_index_of(temp) == -1) {
-            e = {target, temp};
-            unexplored_edges.push_back(e);
-        }
-        temp = {target.first, target.second + 1};
-        if (map_tiles.get_index_of(temp) == -1) {
-            e = {target, temp};
-            unexplored_edges.push_back(e);
-        }
-        temp = {target.first, target.second - 1};
-        if (map_tiles.get_index_of(temp) == -1) {
-            e = {target, temp};
-            unexplored_edges.push_back(e);
-        }
+void Dungeon_Map::reset(const int size) {
+    rooms.clear();
+    analytics.clear();
 
-        //decrement num_tiles;
-        num_tiles--;
+    for (int i = 0; i < size; i++) {
+        auto temp = tile();
+        rooms.add_vertex(temp);
     }
+}
+
+/**
+ * add_loops connects randomly chosen pairs of adjacent tiles that are not connected yet. It collects every such pair in
+ * @var loop_candidates by looking east and north of each tile in @var layout_positions, so every pair is considered
+ * once, then shuffles the first @param extra_edges pairs into place with a partial Fisher-Yates shuffle and connects
+ * them. If there are fewer pairs than @param extra_edges all of them are connected.
+ * @param extra_edges: the number of connections to add
+ * @param random_number_generator: the random number generator used to choose the pairs
+ */
+void Dungeon_Map::add_loops(const int extra_edges, std::mt19937 &random_number_generator) {
+    const auto &positions = layout_positions;
+    auto &candidates = loop_candidates;
 
-    //for each room in rooms
+    //collect every adjacent pair of tiles that isn't connected
+    candidates.clear();
     for (int i = 0; i < rooms.get_size(); i++) {
-        //set the relative position of that room to be equal to the position at the same index in map_tiles
-        rooms.get_vertex(i).relative_position = map_tiles.get_vertex(i);
-        //for each edge in map_tiles connected to vertex i
-        //place an equivalent edge in rooms
-        for (const auto j : map_tiles.get_edges(i)) {
-            rooms.add_edge(i, j);
+        const auto [x, y] = rooms.get_vertex(i).relative_position;
+        for (const auto &neighbour : {std::pair{x + 1, y}, std::pair{x, y + 1}}) {
+            const int found = positions.find(neighbour);
+            if (found != -1 && std::ranges::find(rooms.get_edges(i), found) == rooms.get_edges(i).end()) {
+                candidates.emplace_back(i, found);
+            }
         }
     }
+
+    //pick and connect extra_edges of them at random
+    const std::size_t count = std::min<std::size_t>(std::max(extra_edges, 0), candidates.size());
+    for (std::size_t i = 0; i < count; i++) {
+        std::swap(candidates[i], candidates[i + random_number_generator() % (candidates.size() - i)]);
+        rooms.add_edge(candidates[i].first, candidates[i].second);
+    }
 }
 
 /**
@@ -196,16 +117,32 @@ void Dungeon_Map::place_exits(){
 }
 
 /**
- * generate_dungeon_svg calculates the necessary offsets, and prints all lines to the Dungeon_Map.svg
+ * generate_dungeon_svg opens Dungeon_Map.svg and hands it to write_dungeon_svg, which does the actual work of printing
+ * the map.
+ * @param random_number_generator: the pre-seeded random number generator passed on to write_dungeon_svg
+ */
+void Dungeon_Map::generate_dungeon_svg(std::mt19937 random_number_generator) {
+    //open the file
+    std::ofstream mapFile = std::ofstream("Dungeon_Map.svg");
+    //write the map to the file and close it
+    write_dungeon_svg(mapFile, random_number_generator);
+    mapFile.close();
+}
+
+/**
+ * write_dungeon_svg calculates the necessary offsets, and prints all lines to @param output
  * It starts by iterating all the rooms and finding the maximum and minimum values of the relative positions of each room
  * these values are used to calculate the width and height values of the SVG image. In addition, the minimum values are used
  * to calculate the true positions of each tile in the dungeon svg such that they maintain the same relative positions.
  *
- * the function prints the SVG header to Dungeon_Map.svg
- * then it iterates through each room printing the SVG string generated for that room to Dungeon_Map.svg
- * finally it prints the SVG footer to Dungeon_Map.svg
+ * the function prints the SVG header to @param output
+ * then it iterates through each room printing the SVG string generated for that room to @param output
+ * finally it prints the SVG footer to @param output
+ *
+ * @param output: the stream the SVG is written to, tile by tile
+ * @param random_number_generator: the pre-seeded random number generator used by SVG_tile
  */
-void Dungeon_Map::generate_dungeon_svg(std::mt19937 random_number_generator) {
+void Dungeon_Map::write_dungeon_svg(std::ostream &output, std::mt19937 random_number_generator) {
     //declare and initialize necessary variables
     int minX = 0, minY = 0, maxX = 0, maxY = 0;
     //for every room
@@ -229,20 +166,126 @@ void Dungeon_Map::generate_dungeon_svg(std::mt19937 random_number_generator) {
     int mapWidth = (maxX - minX) * TILE_SIZE;
     int mapHeight = (maxY - minY) * TILE_SIZE;
 
-    //open the file
-    std::ofstream mapFile = std::ofstream("Dungeon_Map.svg");
     //write the SVG header
-    mapFile << SVGHead(mapWidth + TILE_SIZE, mapHeight + TILE_SIZE);
+    output << SVGHead(mapWidth + TILE_SIZE, mapHeight + TILE_SIZE);
 
-    //write each room to the file
+    //write each room to the stream, stopping early if the stream fails since nobody will see the rest
     place_exits();
+    for (int i = 0; i < rooms.get_size() && output; i++) {
+        output << SVG_tile(i, minX, minY, random_number_generator) << "\n";
+    }
+
+    //Write the footer
+    output << SVGEnd();
+    output.flush();
+}
+
+/**
+ * write_dungeon_layout prints the raw layout of the dungeon to @param output without rendering it. the first line is
+ * the number of tiles, followed by one line per tile in index order of the form "x y n1 n2 ..." where x and y are the
+ * relative position of the tile and n1, n2, ... are the indexes of the tiles it is connected to.
+ * @param output: the stream the layout is written to
+ */
+void Dungeon_Map::write_dungeon_layout(std::ostream &output) {
+    output << rooms.get_size() << "\n";
+    for (int i = 0; i < rooms.get_size() && output; i++) {
+        const auto &[x, y] = rooms.get_vertex(i).relative_position;
+        output << x << ' ' << y;
+        for (const int j : rooms.get_edges(i)) {
+            output << ' ' << j;
+        }
+        output << "\n";
+    }
+    output.flush();
+}
+
+/**
+ * analyze_layout finds root, the tile at relative position (0, 0), and runs a breadth first search from it to fill in
+ * the depth and parent of every tile. walking the visit order backwards adds the subtree size of every tile to its
+ * parent, so each tile is counted once in every tile between it and root. dead ends are the tiles other than root with a
+ * single connection.
+ *
+ * the longest path is found with two breadth first searches: the tile furthest from root is always one end of a longest
+ * path in a tree, so a second search from that tile finds the other end, and following parents back from the other end
+ * gives the path. every step visits each tile and connection a constant number of times.
+ *
+ * on layouts with loops (see Layout::With_Loops) depth is still the shortest distance from root, parent and
+ * subtree_size describe the breadth first search tree, and longest_path is a long shortest path that is not guaranteed
+ * to be the longest.
+ *
+ * @return the analytics of the current layout
+ */
+const Dungeon_Map::layout_analytics &Dungeon_Map::analyze_layout() {
+    analytics.clear();
+    if (rooms.get_size() == 0) {
+        return analytics;
+    }
+
+    //find the root tile at (0, 0)
+    analytics.root = 0;
     for (int i = 0; i < rooms.get_size(); i++) {
-        mapFile << SVG_tile(i, minX, minY, random_number_generator) << std::endl;
+        if (rooms.get_vertex(i).relative_position == std::pair<int, int>{0, 0}) {
+            analytics.root = i;
+            break;
+        }
     }
 
-    //Write the footer and close the file
-    mapFile << SVGEnd();
-    mapFile.close();
+    //breadth first search from root for depth and parent
+    std::vector<int> order;
+    rooms.breadth_first_search(analytics.root, analytics.depth, analytics.parent, order);
+
+    //accumulate subtree sizes from the deepest tiles up
+    analytics.subtree_size.assign(rooms.get_size(), 1);
+    for (auto i = order.rbegin(); i != order.rend(); ++i) {
+        if (analytics.parent[*i] != -1) {
+            analytics.subtree_size[analytics.parent[*i]] += analytics.subtree_size[*i];
+        }
+    }
+
+    //collect the dead ends
+    for (int i = 0; i < rooms.get_size(); i++) {
+        if (i != analytics.root && rooms.get_edges(i).size() == 1) {
+            analytics.dead_ends.push_back(i);
+        }
+    }
+
+    //the last tile visited is furthest from root and therefore one end of a longest path, search again from there
+    const int first_end = order.back();
+    std::vector<int> end_depth, end_parent;
+    rooms.breadth_first_search(first_end, end_depth, end_parent, order);
+    const int second_end = order.back();
+
+    //walk back from the second end to the first end to get the path
+    analytics.diameter = end_depth[second_end];
+    for (int i = second_end; i != -1; i = end_parent[i]) {
+        analytics.longest_path.push_back(i);
+    }
+
+    return analytics;
+}
+
+/**
+ * write_layout_analytics prints the analytics from the last call to analyze_layout(). the first line is
+ * "root <index> diameter <length>", the second is "longest_path" followed by the tile indexes along the path, the third
+ * is "dead_ends" followed by the dead end tile indexes, followed by one line per tile in index order of the form
+ * "depth parent subtree_size".
+ * @param output: the stream the analytics are written to
+ */
+void Dungeon_Map::write_layout_analytics(std::ostream &output) const {
+    output << "root " << analytics.root << " diameter " << analytics.diameter << "\n";
+    output << "longest_path";
+    for (const int i : analytics.longest_path) {
+        output << ' ' << i;
+    }
+    output << "\ndead_ends";
+    for (const int i : analytics.dead_ends) {
+        output << ' ' << i;
+    }
+    output << "\n";
+    for (std::size_t i = 0; i < analytics.depth.size() && output; i++) {
+        output << analytics.depth[i] << ' ' << analytics.parent[i] << ' ' << analytics.subtree_size[i] << "\n";
+    }
+    output.flush();
 }
 
 /**
@@ -5,6 +5,9 @@
 #ifndef RDG_UNLIMITED_DUNGEON_MAP_H
 #define RDG_UNLIMITED_DUNGEON_MAP_H
 #include "../Helper_Classes_&_Files/Adjacency_List.h"
+#include "../Helper_Classes_&_Files/Position_Map.h"
+#include "Layout_Policies.h"
+#include <ostream>
 #include <random>
 
 /**
@@ -14,16 +17,61 @@
  *
  * Dpendencies:
  *      - Adjacency_List.h
+ *      - Position_Map.h
+ *      - Layout_Policies.h
  *      - SVG.h
  *
  * Types:
  *      - @struct tile
  *      - @enum direction
+ *      - @struct layout_analytics
  *
  * Attributes:
  *      - @var rooms: an adjacency list of tiles that is used to store the connections between tiles and corridors
+ *      - @var analytics: the results of the last call to analyze_layout()
+ *      - @var layout_positions, @var layout_frontier, @var loop_candidates: scratch space of generate_dungeon_layout
+ *        that is kept between calls so a reused map doesn't have to grow it again
  */
 class Dungeon_Map {
+public:
+    /**
+     * The layout_analytics structure holds the graph measurements of a generated layout that later stages use to
+     * populate and render the dungeon. all per-tile vectors are indexed the same way as the tiles in rooms.
+     * parent and subtree_size describe the breadth first search tree from root. while the layout is a tree that is the
+     * layout itself, once loops have been added (see Layout::With_Loops) it is one of the shortest path trees of it.
+     * @var root: the index of the tile at relative position (0, 0), the entrance of the dungeon
+     * @var depth: the fewest passages between root and each tile
+     * @var parent: the tile each tile is first reached from when walking out from root, -1 for root. when a tile can be
+     *      reached from several tiles at the same depth the one visited first by the search wins, so parent only
+     *      depends on the layout
+     * @var subtree_size: the number of tiles, including itself, below each tile in the search tree. on a tree these are
+     *      the tiles that can only be reached from root through that tile, with loops some of them have other routes
+     * @var dead_ends: the indexes of every tile other than root that has exactly one exit
+     * @var longest_path: the indexes of the tiles along a longest path through the dungeon, from one end to the other.
+     *      with loops this is a long shortest path between two tiles that is not guaranteed to be the longest
+     * @var diameter: the number of passages along longest_path
+     */
+    struct layout_analytics {
+        int root = -1;
+        std::vector<int> depth;
+        std::vector<int> parent;
+        std::vector<int> subtree_size;
+        std::vector<int> dead_ends;
+        std::vector<int> longest_path;
+        int diameter = 0;
+
+        //empties every measurement while keeping the memory of the vectors for the next layout
+        void clear() {
+            root = -1;
+            depth.clear();
+            parent.clear();
+            subtree_size.clear();
+            dead_ends.clear();
+            longest_path.clear();
+            diameter = 0;
+        }
+    };
+
 private:
     /**
      * The direction enum stores the values NORTH, EAST, WEST, and SOUTH. used primarily for readability purposes the
@@ -52,6 +100,16 @@ private:
     //The Adjacency list containing all tiles in the dungeon.
     Adjacency_List<tile> rooms;
 
+    //The analytics of the layout in rooms, filled in by analyze_layout()
+    layout_analytics analytics;
+
+    //The index in rooms of the tile at each relative position, filled in by generate_dungeon_layout
+    Position_Map layout_positions;
+    //The edges generate_dungeon_layout may still grow along
+    std::vector<Layout::frontier_edge> layout_frontier;
+    //The adjacent unconnected pairs of tiles add_loops chooses from
+    std::vector<std::pair<int, int>> loop_candidates;
+
     /**
      * SVG_tile generates the SVG strings that represents a specific_tile in the grid and returns it. any rooms
      * are generated in random part of the tile rounded to the nearest multiple of 5 bits on the vertical and horizontal
@@ -74,6 +132,14 @@ private:
      * that all rooms have the required exit flags for SVG_tile to connect draw passages in the correct directions.
      */
     void place_exits();
+
+    /**
+     * add_loops is the post-pass of Layout::With_Loops. it connects up to @param extra_edges random pairs of adjacent
+     * tiles that are not connected yet, looking the tiles up in @var layout_positions.
+     * @param extra_edges: the number of connections to add
+     * @param random_number_generator: the random number generator used to choose the pairs
+     */
+    void add_loops(int extra_edges, std::mt19937 &random_number_generator);
 public:
     /**
      * The constructor for Dungeon_Map initializes rooms and populates it with the specified number of tiles.
@@ -81,13 +147,29 @@ public:
      */
     explicit Dungeon_Map(int size);
 
+    /**
+     * reset discards the current layout and its analytics and refills rooms with the specified number of fresh tiles,
+     * reusing the memory of the previous layout so that one Dungeon_Map can generate many dungeons.
+     * @param size: the number of tiles in the new dungeon
+     */
+    void reset(int size);
+
+    /**
+     * returns the number of tiles in the dungeon
+     */
+    [[nodiscard]] int get_size() const {
+        return rooms.get_size();
+    }
+
     /**
      * generate_dungeon_layout generates the general structure and layout of tiles relative to each-other including
      * determining which tiles are connected to each-other. direction of passages are inferred later on by place_exits()
      * based on the relative positions of tiles that are connected to each-other. The algorithm starts with a single room
-     * and continues placing rooms next to generated rooms until it has generated a room for each tile in rooms.
+     * and continues placing rooms next to generated rooms until it has generated a room for each tile in rooms. Which
+     * room is placed next is decided by @tparam Growth_Policy, see Layout_Policies.h.
      * @param random_number_generator: the pre-seeded random number generator used to select random unexplored edges
      */
+    template<typename Growth_Policy = Layout::Uniform_Frontier>
     void generate_dungeon_layout(std::mt19937 random_number_generator);
 
     /**
@@ -96,7 +178,135 @@ public:
      * the SVG header. All the SVG information is written to Dungoen_Map.svg
      */
     void generate_dungeon_svg(std::mt19937 random_number_generator);
+
+    /**
+     * write_dungeon_svg does the same work as generate_dungeon_svg but writes the SVG to the given stream instead of
+     * Dungeon_Map.svg, one tile at a time, so the map can be sent somewhere without touching the disk.
+     * @param output: the stream the SVG is written to
+     * @param random_number_generator: the pre-seeded random number generator used to generate the room in each tile
+     */
+    void write_dungeon_svg(std::ostream &output, std::mt19937 random_number_generator);
+
+    /**
+     * write_dungeon_layout writes the relative position and connections of every tile to the given stream as plain
+     * text, for consumers that want the layout rather than a rendered map.
+     * @param output: the stream the layout is written to
+     */
+    void write_dungeon_layout(std::ostream &output);
+
+    /**
+     * analyze_layout measures the generated layout in linear time: the depth of every tile from the entrance at (0, 0),
+     * the size of the part of the dungeon behind every tile, the dead ends and a longest path through the dungeon. On
+     * layouts with loops the results are only approximate, see layout_analytics. The results are kept until the next
+     * call so population and rendering can share them.
+     * @return the analytics of the current layout
+     */
+    const layout_analytics &analyze_layout();
+
+    /**
+     * write_layout_analytics writes the results of analyze_layout() to the given stream as plain text.
+     * @param output: the stream the analytics are written to
+     */
+    void write_layout_analytics(std::ostream &output) const;
 };
 
+/* TEMPLATE DEFINITIONS */
+/**
+ * generate_dungeon_layout utilizes the basic concepts of randomized frontier growth to generate a random dungeon layout
+ * over an unbounded plane limited by the number of tiles in @var rooms.
+ *
+ * the algorithm is as follows:
+ *      Clear @var layout_positions, a map from X,Y coordinate pairs to the index of the tile placed there;
+ *      Clear @var layout_frontier, a vector of edges from placed tiles to positions that may still be unplaced;
+ *
+ *      place the first tile at the origin(0,0) and add all of its direct neighbors to frontier;
+ *      while( the number of rooms to place is greater than 0 ){
+ *          ask Growth_Policy to select an edge in frontier and remove it;
+ *          if the target of that edge has already been placed, select again;
+ *          place the next tile at the target and connect it to the tile at the origin;
+ *          add all edges of the new tile that go to an unplaced position to frontier;
+ *          decrement number of rooms to place;
+ *      }
+ *      if Growth_Policy has extra_edges, call add_loops() to connect that many adjacent unconnected tiles;
+ *
+ * edges whose target was placed through another edge are only discarded when they are selected, which keeps every step
+ * constant time on average while giving every valid edge the same chance of being picked as removing them eagerly.
+ * both scratch structures are members that are emptied once the layout is done rather than rebuilt, so a map that is
+ * reset and regenerated reuses the memory of previous layouts.
+ *
+ * Without extra edges the layout maintains two primary principles:
+ *      1. the paths through the dungeon are random
+ *      2. if graphed as a set of nodes and edges the dungeon forms a tree from the tile at relative position 0,0 as
+ *         root. the graph has no cycles or loops.
+ *
+ * @tparam Growth_Policy: the policy that selects which frontier edge to grow along next
+ * @param random_number_generator: the pre-seeded random number generator used to select random unexplored edges
+ */
+template<typename Growth_Policy>
+void Dungeon_Map::generate_dungeon_layout(std::mt19937 random_number_generator) {
+    using Layout::frontier_edge;
+
+    const int size = rooms.get_size();
+    if (size == 0) {
+        return;
+    }
+
+    auto &positions = layout_positions;
+    auto &frontier = layout_frontier;
+    positions.clear();
+    positions.reserve(size);
+    frontier.clear();
+    frontier.reserve(3 * static_cast<std::size_t>(size) + 4);
+
+    //adds an edge from origin to each unplaced neighbouring position
+    auto add_frontier = [&](const std::pair<int, int> &origin) {
+        for (const auto &target : {std::pair{origin.first + 1, origin.second},
+                                   std::pair{origin.first - 1, origin.second},
+                                   std::pair{origin.first, origin.second + 1},
+                                   std::pair{origin.first, origin.second - 1}}) {
+            if (!positions.contains(target)) {
+                frontier.push_back({origin, target});
+            }
+        }
+    };
+
+    //define the first space in the area as being at position (zero, zero)
+    const std::pair<int, int> root = {0, 0};
+    rooms.get_vertex(0).relative_position = root;
+    positions.emplace(root, 0);
+    add_frontier(root);
+    frontier_edge last = {root, root};
+
+    //while there are still tiles to place
+    for (int placed = 1; placed < size;) {
+        //let the policy select an edge and remove it from the frontier
+        const std::size_t selected = Growth_Policy::select(frontier, last, random_number_generator);
+        const frontier_edge e = frontier[selected];
+        frontier[selected] = frontier.back();
+        frontier.pop_back();
+
+        //skip edges to positions that were placed through another edge
+        if (positions.contains(e.target)) {
+            continue;
+        }
+
+        //place the next tile at the target and connect it to the origin
+        rooms.get_vertex(placed).relative_position = e.target;
+        positions.emplace(e.target, placed);
+        rooms.add_edge(positions.at(e.origin), placed);
+        add_frontier(e.target);
+        last = e;
+        placed++;
+    }
+
+    if constexpr (requires { Growth_Policy::extra_edges; }) {
+        add_loops(Growth_Policy::extra_edges, random_number_generator);
+    }
+
+    //empty the scratch space now so the cost of clearing a large layout isn't paid by the next, possibly small, one
+    positions.clear();
+    frontier.clear();
+}
+
 
 #endif //RDG_UNLIMITED_DUNGEON_MAP_H
\ No newline at end of file
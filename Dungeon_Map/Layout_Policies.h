@@ -0,0 +1,102 @@
+//
+// Created by aowyn on 10/19/26.
+//
+
+#ifndef RDG_UNLIMITED_LAYOUT_POLICIES_H
+#define RDG_UNLIMITED_LAYOUT_POLICIES_H
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+/**
+ * Layout contains the growth policies that Dungeon_Map::generate_dungeon_layout is specialized on. The layout engine
+ * keeps a frontier of edges from placed tiles to unplaced positions, and each step asks the policy which frontier edge
+ * to grow along. Policies are plain structs with a static select function so the engine's hot loop is compiled
+ * separately for every policy instead of going through a virtual call.
+ *
+ * A growth policy must provide:
+ *      static std::size_t select(const std::vector<frontier_edge> &frontier, const frontier_edge &last,
+ *                                std::mt19937 &random_number_generator);
+ * which returns the index of the edge in frontier to grow along. @param last is the edge that placed the most recent
+ * tile, and the edges leading out of that tile are always the last ones in frontier. The engine discards any selected
+ * edge whose target has already been placed and asks again.
+ *
+ * A policy that also provides a static constexpr int extra_edges gets that many loops added once the tree has grown,
+ * see With_Loops.
+ */
+namespace Layout {
+
+/**
+ * @struct frontier_edge defines an edge from the placed tile at cartesian point origin to the cartesian point target.
+ */
+struct frontier_edge {
+    std::pair<int, int> origin; //the cartesian coordinate of the origin point
+    std::pair<int, int> target; //the cartesian coordinate of the target point
+};
+
+/**
+ * Uniform_Frontier grows along a uniformly random frontier edge. This is the original algorithm and creates very
+ * clustered, close to circular layouts.
+ */
+struct Uniform_Frontier {
+    static std::size_t select(const std::vector<frontier_edge> &frontier, const frontier_edge &,
+                              std::mt19937 &random_number_generator) {
+        return random_number_generator() % frontier.size();
+    }
+};
+
+/**
+ * Biased_DFS behaves like a randomized depth first search: it usually grows from one of the newest frontier edges,
+ * which continues from the last placed tile or backtracks to the closest tile with room left, and only branches from a
+ * uniformly random edge @tparam Branch_Percent percent of the time. This creates long winding maze-like paths.
+ */
+template<int Branch_Percent = 10>
+struct Biased_DFS {
+    static std::size_t select(const std::vector<frontier_edge> &frontier, const frontier_edge &,
+                              std::mt19937 &random_number_generator) {
+        if (static_cast<int>(random_number_generator() % 100) < Branch_Percent) {
+            return random_number_generator() % frontier.size();
+        }
+        const std::size_t recent = std::min<std::size_t>(frontier.size(), 3);
+        return frontier.size() - 1 - random_number_generator() % recent;
+    }
+};
+
+/**
+ * Corridor_First keeps growing in a straight line from the last placed tile @tparam Straight_Percent percent of the
+ * time, and otherwise grows along a uniformly random frontier edge. This creates long corridors that branch off from
+ * each other.
+ */
+template<int Straight_Percent = 80>
+struct Corridor_First {
+    static std::size_t select(const std::vector<frontier_edge> &frontier, const frontier_edge &last,
+                              std::mt19937 &random_number_generator) {
+        if (static_cast<int>(random_number_generator() % 100) < Straight_Percent) {
+            //the position one step further in the direction of the last edge
+            const std::pair<int, int> ahead = {2 * last.target.first - last.origin.first,
+                                               2 * last.target.second - last.origin.second};
+            //the edges out of the last placed tile are at most the last four in frontier
+            for (std::size_t i = frontier.size(); i > 0 && i + 4 > frontier.size(); i--) {
+                if (frontier[i - 1].origin == last.target && frontier[i - 1].target == ahead) {
+                    return i - 1;
+                }
+            }
+        }
+        return random_number_generator() % frontier.size();
+    }
+};
+
+/**
+ * With_Loops grows the layout with @tparam Growth_Policy and then connects @tparam Extra_Edges randomly chosen pairs of
+ * adjacent tiles that are not yet connected, turning the tree into a layout with loops. If there are fewer unconnected
+ * adjacent pairs than Extra_Edges all of them are connected.
+ */
+template<typename Growth_Policy, int Extra_Edges>
+struct With_Loops : Growth_Policy {
+    static constexpr int extra_edges = Extra_Edges;
+};
+
+} // Layout
+
+#endif //RDG_UNLIMITED_LAYOUT_POLICIES_H
@@ -0,0 +1,427 @@
+//
+// Created by aowyn on 10/19/26.
+//
+#include "Dungeon_Server.h"
+
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <poll.h>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+/* CONSTANTS */
+constexpr int MAX_REQUEST_LENGTH = 256; //the longest request line the server will read
+constexpr int REQUEST_TIMEOUT_MS = 2000; //how long a client has to send its request line, and each send may block for
+constexpr int MAX_DUNGEON_SIZE = 1000000; //the largest layout or analytics request, about 2 seconds of generation
+constexpr int MAX_SVG_SIZE = 20000; //the largest svg request, rendering is far slower than generating the layout
+constexpr int WARM_UP_SIZE = 2000; //the number of tiles each worker generates once before serving requests
+constexpr int STREAM_BUFFER_SIZE = 1 << 16; //the number of bytes buffered before they are sent over the socket
+constexpr std::string_view END_OF_RESPONSE = "\nEND\n"; //sent after every complete response, see request_dungeon
+
+/**
+ * Socket_Buffer is a minimal output stream buffer that sends its contents over a connected socket whenever it fills up
+ * or is flushed, which lets Dungeon_Map stream its output to a client through a regular std::ostream.
+ * MSG_NOSIGNAL is used so that a client hanging up mid-response fails the stream instead of raising SIGPIPE.
+ */
+class Socket_Buffer final : public std::streambuf {
+private:
+    int connection;
+    char buffer[STREAM_BUFFER_SIZE];
+
+    bool send_buffer() {
+        const char *data = pbase();
+        std::size_t remaining = pptr() - pbase();
+        while (remaining > 0) {
+            const ssize_t sent = send(connection, data, remaining, MSG_NOSIGNAL);
+            if (sent <= 0) {
+                return false;
+            }
+            data += sent;
+            remaining -= sent;
+        }
+        setp(buffer, buffer + STREAM_BUFFER_SIZE);
+        return true;
+    }
+protected:
+    int_type overflow(const int_type c) override {
+        if (!send_buffer()) {
+            return traits_type::eof();
+        }
+        if (!traits_type::eq_int_type(c, traits_type::eof())) {
+            *pptr() = traits_type::to_char_type(c);
+            pbump(1);
+        }
+        return traits_type::not_eof(c);
+    }
+
+    int sync() override {
+        return send_buffer() ? 0 : -1;
+    }
+public:
+    explicit Socket_Buffer(const int connection) : connection(connection) {
+        setp(buffer, buffer + STREAM_BUFFER_SIZE);
+    }
+};
+
+/**
+ * open_socket creates a Unix domain stream socket and fills in the address for @param socket_path.
+ * @throws std::runtime_error if the socket cannot be created or the path does not fit in sockaddr_un
+ */
+static int open_socket(const std::string &socket_path, sockaddr_un &address) {
+    if (socket_path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("ERROR in Dungeon_Server: socket path too long: " + socket_path);
+    }
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, socket_path.c_str(), socket_path.size() + 1);
+
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        throw std::runtime_error(std::string("ERROR in Dungeon_Server: socket: ") + std::strerror(errno));
+    }
+    return fd;
+}
+
+/**
+ * remove_stale_socket makes @param socket_path free to bind to. Nothing is done if the path doesn't exist. If it is a
+ * socket that refuses connections it was left behind by a server that is no longer running and is removed. Anything
+ * else at the path, a regular file or a socket a live server is listening on, is left untouched.
+ * @throws std::runtime_error if the path exists and is not a stale socket
+ */
+static void remove_stale_socket(const std::string &socket_path, const sockaddr_un &address) {
+    struct stat info{};
+    if (lstat(socket_path.c_str(), &info) != 0) {
+        return;
+    }
+    if (!S_ISSOCK(info.st_mode)) {
+        throw std::runtime_error("ERROR in Dungeon_Server::run: " + socket_path + " exists and is not a socket");
+    }
+
+    const int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (probe < 0) {
+        throw std::runtime_error(std::string("ERROR in Dungeon_Server: socket: ") + std::strerror(errno));
+    }
+    const bool live = connect(probe, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) == 0;
+    const int error = errno;
+    close(probe);
+    if (live) {
+        throw std::runtime_error("ERROR in Dungeon_Server::run: a server is already listening on " + socket_path);
+    }
+    if (error != ECONNREFUSED) {
+        throw std::runtime_error("ERROR in Dungeon_Server::run: cannot check " + socket_path + ": " + std::strerror(error));
+    }
+    unlink(socket_path.c_str());
+}
+
+/**
+ * read_request_line reads from @param connection until the first newline, MAX_REQUEST_LENGTH bytes or the client
+ * closing the connection, whichever comes first, and stores everything before the newline in @param line. Data is read
+ * in chunks as it arrives, and the whole line has to arrive within REQUEST_TIMEOUT_MS so a client that never finishes
+ * its request cannot hold a worker.
+ * @return false if the deadline passed or the connection failed before the line was complete
+ */
+static bool read_request_line(const int connection, std::string &line) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(REQUEST_TIMEOUT_MS);
+    char buffer[MAX_REQUEST_LENGTH];
+    line.clear();
+
+    while (line.size() < MAX_REQUEST_LENGTH) {
+        const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+        pollfd ready = {connection, POLLIN, 0};
+        if (remaining <= 0 || poll(&ready, 1, static_cast<int>(remaining)) <= 0) {
+            return false;
+        }
+
+        const ssize_t received = recv(connection, buffer, MAX_REQUEST_LENGTH - line.size(), 0);
+        if (received < 0) {
+            return false;
+        }
+        if (received == 0) {
+            return true;
+        }
+        line.append(buffer, received);
+
+        const auto newline = line.find('\n');
+        if (newline != std::string::npos) {
+            line.resize(newline);
+            return true;
+        }
+    }
+    return true;
+}
+
+/**
+ * elapsed_ms returns the number of milliseconds between two points in time as a double.
+ */
+static double elapsed_ms(const std::chrono::steady_clock::time_point start, const std::chrono::steady_clock::time_point end) {
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+/* METHOD DEFINITIONS */
+Dungeon_Server::Dungeon_Server(std::string socket_path, const int worker_count)
+    : socket_path(std::move(socket_path)), worker_count(worker_count < 1 ? 1 : worker_count),
+      active_connections(this->worker_count) {
+    for (auto &connection : active_connections) {
+        connection = -1;
+    }
+}
+
+Dungeon_Server::~Dungeon_Server() {
+    stop();
+}
+
+/**
+ * run removes any stale socket left behind at @var socket_path (see remove_stale_socket), binds and listens on a new
+ * socket and starts @var worker_count workers. It then accepts connections and queues them for the workers until
+ * stop() shuts the listening socket down, at which point it wakes the workers, waits for them to finish any request in
+ * progress and removes the socket file.
+ */
+void Dungeon_Server::run() {
+    sockaddr_un address{};
+    listen_fd = open_socket(socket_path, address);
+    try {
+        remove_stale_socket(socket_path, address);
+    }
+    catch (const std::runtime_error &) {
+        close(listen_fd);
+        listen_fd = -1;
+        throw;
+    }
+    if (bind(listen_fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0 || listen(listen_fd, SOMAXCONN) < 0) {
+        const std::string error = std::strerror(errno);
+        close(listen_fd);
+        listen_fd = -1;
+        throw std::runtime_error("ERROR in Dungeon_Server::run: cannot listen on " + socket_path + ": " + error);
+    }
+
+    running = true;
+    for (int i = 0; i < worker_count; i++) {
+        workers.emplace_back(&Dungeon_Server::worker_loop, this, i);
+    }
+    std::clog << "Dungeon_Server listening on " << socket_path << " with " << worker_count << " workers" << std::endl;
+
+    //accept connections until stop() is called
+    while (running) {
+        const int connection = accept(listen_fd, nullptr, nullptr);
+        if (connection < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        {
+            std::lock_guard lock(queue_mutex);
+            pending_connections.push(connection);
+        }
+        queue_ready.notify_one();
+    }
+
+    //wake the workers so they notice the server has stopped and wait for them to exit. running is changed under
+    //queue_mutex so a worker can't check it and then miss the notification before it starts waiting
+    {
+        std::lock_guard lock(queue_mutex);
+        running = false;
+    }
+    queue_ready.notify_all();
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+
+    close(listen_fd);
+    listen_fd = -1;
+    unlink(socket_path.c_str());
+}
+
+/**
+ * stop shuts the listening socket down so accept() fails in run(), and shuts down every connection a worker is still
+ * serving so a worker blocked on a slow client returns straight away. run() then tells the workers to exit, stop()
+ * can't do that itself because it may be called from a signal handler where taking queue_mutex is not allowed.
+ */
+void Dungeon_Server::stop() {
+    if (listen_fd >= 0) {
+        shutdown(listen_fd, SHUT_RDWR);
+    }
+    for (const auto &connection : active_connections) {
+        const int fd = connection.load();
+        if (fd >= 0) {
+            shutdown(fd, SHUT_RDWR);
+        }
+    }
+}
+
+/**
+ * worker_loop generates a throwaway dungeon of WARM_UP_SIZE tiles so the worker's Dungeon_Map has already grown its
+ * tiles, edge lists and layout scratch space before the first real request arrives. The map is only ever reset, so
+ * that storage, and anything a larger request grows it to, is reused by every later request. The worker then
+ * repeatedly takes the oldest pending connection and serves it. While a connection is being served it is published in
+ * @var active_connections so stop() can shut it down, and it is removed from there before it is closed. Connections
+ * still queued when the server stops are closed without a response.
+ */
+void Dungeon_Server::worker_loop(const int worker_id) {
+    Dungeon_Map map(WARM_UP_SIZE);
+    map.generate_dungeon_layout(std::mt19937(worker_id));
+
+    while (true) {
+        int connection;
+        {
+            std::unique_lock lock(queue_mutex);
+            queue_ready.wait(lock, [this] { return !running || !pending_connections.empty(); });
+            if (!running) {
+                break;
+            }
+            connection = pending_connections.front();
+            pending_connections.pop();
+        }
+        active_connections[worker_id] = connection;
+        serve_connection(connection, map, worker_id);
+        active_connections[worker_id] = -1;
+        close(connection);
+    }
+
+    std::lock_guard lock(queue_mutex);
+    while (!pending_connections.empty()) {
+        close(pending_connections.front());
+        pending_connections.pop();
+    }
+}
+
+/**
+ * serve_connection sets a send timeout on the connection so a client that stops reading cannot hold the worker, reads
+ * the request line, validates it, and either reports the aggregate metrics or resets the worker's map to the
+ * requested size, generates the layout with a generator seeded by the request and streams the result back in the
+ * requested format. The time spent generating the layout and rendering the response is recorded.
+ */
+void Dungeon_Server::serve_connection(const int connection, Dungeon_Map &map, const int worker_id) {
+    const auto start = std::chrono::steady_clock::now();
+
+    constexpr timeval send_timeout = {REQUEST_TIMEOUT_MS / 1000, REQUEST_TIMEOUT_MS % 1000 * 1000};
+    setsockopt(connection, SOL_SOCKET, SO_SNDTIMEO, &send_timeout, sizeof(send_timeout));
+
+    //read until the end of the request line, dropping clients that take too long
+    std::string line;
+    if (!read_request_line(connection, line)) {
+        return;
+    }
+
+    Socket_Buffer buffer(connection);
+    std::ostream output(&buffer);
+
+    if (line == "stats") {
+        std::lock_guard lock(metrics_mutex);
+        output << "served " << served << "\n"
+               << "mean_ms " << (served > 0 ? total_ms / static_cast<double>(served) : 0.0) << "\n"
+               << "max_ms " << max_ms << "\n";
+        output << END_OF_RESPONSE;
+        output.flush();
+        return;
+    }
+
+    //the seed is read as text and parsed with from_chars, which unlike stream extraction rejects negative numbers
+    //instead of wrapping them around, and nothing but whitespace may follow the format
+    request req;
+    std::string seed;
+    std::istringstream fields(line);
+    const bool read = static_cast<bool>(fields >> req.size >> seed >> req.format);
+    const auto [seed_end, seed_error] = std::from_chars(seed.data(), seed.data() + seed.size(), req.seed);
+    if (!read || seed_error != std::errc() || seed_end != seed.data() + seed.size() || !(fields >> std::ws).eof() ||
+        req.size < 1 || req.size > (req.format == "svg" ? MAX_SVG_SIZE : MAX_DUNGEON_SIZE) ||
+        (req.format != "svg" && req.format != "layout" && req.format != "analytics")) {
+        output << "ERROR: expected \"<size 1-" << MAX_SVG_SIZE << "> <seed> svg\", \"<size 1-" << MAX_DUNGEON_SIZE
+               << "> <seed> <layout|analytics>\" or \"stats\"\n";
+        output << END_OF_RESPONSE;
+        output.flush();
+        return;
+    }
+
+    std::mt19937 generator(req.seed);
+    map.reset(req.size);
+    map.generate_dungeon_layout(generator);
+    const auto generated = std::chrono::steady_clock::now();
+
+    if (req.format == "svg") {
+        map.write_dungeon_svg(output, generator);
+    }
+    else if (req.format == "layout") {
+        map.write_dungeon_layout(output);
+    }
+    else {
+        map.analyze_layout();
+        map.write_layout_analytics(output);
+    }
+    output << END_OF_RESPONSE;
+    output.flush();
+    const auto end = std::chrono::steady_clock::now();
+
+    //a failed or timed out send leaves the client with a truncated response, which is not a served request
+    if (!output) {
+        std::lock_guard lock(metrics_mutex);
+        std::clog << "[worker " << worker_id << "] size=" << req.size << " seed=" << req.seed << " format=" << req.format
+                  << " failed after " << elapsed_ms(start, end) << " ms: the client stopped receiving the response"
+                  << std::endl;
+        return;
+    }
+
+    record_latency(worker_id, req, elapsed_ms(start, generated), elapsed_ms(generated, end), elapsed_ms(start, end));
+}
+
+void Dungeon_Server::record_latency(const int worker_id, const request &req, const double layout_ms,
+                                    const double render_ms, const double total) {
+    std::lock_guard lock(metrics_mutex);
+    served++;
+    total_ms += total;
+    if (total > max_ms) {
+        max_ms = total;
+    }
+    std::clog << "[worker " << worker_id << "] size=" << req.size << " seed=" << req.seed << " format=" << req.format
+              << " layout_ms=" << layout_ms << " render_ms=" << render_ms << " total_ms=" << total << std::endl;
+}
+
+/**
+ * request_dungeon connects to @param socket_path, writes @param request_line followed by a newline and then copies
+ * everything the server sends to @param output until the server closes the connection. The last END_OF_RESPONSE.size()
+ * bytes received are held back until the connection closes, so the marker itself is never written to @param output and
+ * a response that ends without it is reported as truncated.
+ */
+void request_dungeon(const std::string &socket_path, const std::string &request_line, std::ostream &output) {
+    sockaddr_un address{};
+    const int fd = open_socket(socket_path, address);
+    if (connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0) {
+        const std::string error = std::strerror(errno);
+        close(fd);
+        throw std::runtime_error("ERROR in request_dungeon: cannot connect to " + socket_path + ": " + error);
+    }
+
+    const std::string line = request_line + "\n";
+    if (send(fd, line.data(), line.size(), MSG_NOSIGNAL) != static_cast<ssize_t>(line.size())) {
+        close(fd);
+        throw std::runtime_error("ERROR in request_dungeon: failed to send request");
+    }
+
+    char buffer[STREAM_BUFFER_SIZE];
+    std::string tail;
+    ssize_t received;
+    while ((received = read(fd, buffer, sizeof(buffer))) > 0) {
+        tail.append(buffer, received);
+        if (tail.size() > END_OF_RESPONSE.size()) {
+            output.write(tail.data(), static_cast<std::streamsize>(tail.size() - END_OF_RESPONSE.size()));
+            tail.erase(0, tail.size() - END_OF_RESPONSE.size());
+        }
+    }
+    output.flush();
+    close(fd);
+
+    if (received < 0 || tail != END_OF_RESPONSE) {
+        throw std::runtime_error("ERROR in request_dungeon: the response from " + socket_path + " was truncated");
+    }
+}
@@ -0,0 +1,134 @@
+//
+// Created by aowyn on 10/19/26.
+//
+
+#ifndef RDG_UNLIMITED_DUNGEON_SERVER_H
+#define RDG_UNLIMITED_DUNGEON_SERVER_H
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <ostream>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../Dungeon_Map/Dungeon_Map.h"
+
+/**
+ * Dungeon Server is a long-running generator that listens on a local Unix domain socket and serves dungeons from a pool
+ * of worker threads. Each worker owns a Dungeon_Map that is reset rather than rebuilt between requests, so its tiles,
+ * edge lists and layout scratch space keep the capacity of earlier requests and a request mostly pays for the generation
+ * itself rather than process startup and fresh allocations. Responses are streamed straight back over the socket and
+ * never touch the disk.
+ *
+ * Protocol (one request per connection):
+ *      request: a single line "<size> <seed> <format>" where format is "svg", "layout" or "analytics",
+ *               or the single line "stats". svg requests are limited to MAX_SVG_SIZE tiles and the others to
+ *               MAX_DUNGEON_SIZE tiles
+ *      response: the SVG, layout or analytics text of the dungeon (see Dungeon_Map::write_dungeon_svg,
+ *               write_dungeon_layout & write_layout_analytics),
+ *               the aggregate latency metrics of the server for "stats", or a line starting with "ERROR:",
+ *               always followed by the marker "\nEND\n". a response without the marker was cut off
+ *      the server closes the connection once the response has been sent. a response the client stops receiving is
+ *      abandoned, logged as failed and left out of the metrics.
+ *
+ * Dependencies:
+ *      - Dungeon_Map.h
+ *
+ * Attributes:
+ *      - @var socket_path: the file system path of the Unix domain socket
+ *      - @var listen_fd: the listening socket, -1 when the server is not running
+ *      - @var workers: the worker threads, each serving one connection at a time
+ *      - @var pending_connections: accepted connections waiting for a free worker
+ *      - @var active_connections: the connection each worker is serving, -1 while the worker is idle
+ *      - @var served, @var total_ms, @var max_ms: the aggregate latency metrics reported by "stats"
+ */
+class Dungeon_Server {
+private:
+    /**
+     * The request structure holds a parsed generation request.
+     * @var size: the number of tiles in the requested dungeon
+     * @var seed: the seed for the random number generator
+     * @var format: the output format, either "svg", "layout" or "analytics"
+     */
+    struct request {
+        int size = 0;
+        unsigned int seed = 0;
+        std::string format;
+    };
+
+    std::string socket_path;
+    int listen_fd = -1;
+    int worker_count;
+    std::atomic<bool> running = false;
+
+    std::vector<std::thread> workers;
+    std::queue<int> pending_connections;
+    std::mutex queue_mutex;
+    std::condition_variable queue_ready;
+    std::vector<std::atomic<int>> active_connections;
+
+    std::mutex metrics_mutex;
+    long served = 0;
+    double total_ms = 0;
+    double max_ms = 0;
+
+    /**
+     * worker_loop pre-warms a Dungeon_Map and then serves pending connections with it until the server stops.
+     * @param worker_id: the index of the worker, used when logging metrics
+     */
+    void worker_loop(int worker_id);
+
+    /**
+     * serve_connection reads a single request from the connection and writes the response back, the caller closes
+     * the connection afterwards.
+     * @param connection: the file descriptor of the accepted connection
+     * @param map: the warm Dungeon_Map owned by the calling worker
+     * @param worker_id: the index of the calling worker, used when logging metrics
+     */
+    void serve_connection(int connection, Dungeon_Map &map, int worker_id);
+
+    /**
+     * record_latency adds a finished request to the aggregate metrics and logs its individual timings.
+     */
+    void record_latency(int worker_id, const request &req, double layout_ms, double render_ms, double total);
+public:
+    /**
+     * The constructor for Dungeon_Server stores its configuration, the socket is not opened until run() is called.
+     * @param socket_path: the file system path the Unix domain socket is bound to
+     * @param worker_count: the number of worker threads, values less than 1 are treated as 1
+     */
+    Dungeon_Server(std::string socket_path, int worker_count);
+
+    /**
+     * The destructor stops the server if it is still running.
+     */
+    ~Dungeon_Server();
+
+    /**
+     * run binds the socket, starts the worker pool and accepts connections until stop() is called. A socket left
+     * behind by a server that is no longer running is replaced, anything else at the socket path is left alone.
+     * @throws std::runtime_error if the socket path is taken by a file or a live server, or if the socket cannot be
+     *         created, bound or listened on
+     */
+    void run();
+
+    /**
+     * stop makes run() return and wakes up the workers so they can exit, cutting off any request that is still in
+     * progress. It only shuts sockets down, so it is safe to call from a signal handler.
+     */
+    void stop();
+};
+
+/**
+ * request_dungeon connects to a running Dungeon_Server, sends a single request line and copies the response, without
+ * its end of response marker, to output.
+ * @param socket_path: the file system path of the server's Unix domain socket
+ * @param request_line: the request to send, e.g. "2000 42 svg" or "stats"
+ * @param output: the stream the response is written to
+ * @throws std::runtime_error if the server cannot be reached or the response was truncated
+ */
+void request_dungeon(const std::string &socket_path, const std::string &request_line, std::ostream &output);
+
+#endif //RDG_UNLIMITED_DUNGEON_SERVER_H
@@ -12,7 +12,7 @@
  * ATTRIBUTES:
  * @var vertices, a vector of all values stored in the graph, this is changed very little
  * @var adjacency, A list containing all vertex connections. each vertex's connections are stored at the same index
- *      as the value of that vertex in vertices
+ *      as the value of that vertex in vertices, lists past index size - 1 are spare lists kept by clear() for reuse
  * @var visited, a list of booleans determining weather or not a vertex has been visited during searching algorithms
  *      currently only used in randomized_first_search
  * @var size, The number of vertices in the graph.
@@ -52,7 +52,13 @@ public:
      */
     void add_vertex(T &value) {
         vertices.emplace_back(value);
-        edges.emplace_back();
+        //reuse an edge list kept by clear() if there is one
+        if (size < static_cast<int>(edges.size())) {
+            edges[size].clear();
+        }
+        else {
+            edges.emplace_back();
+        }
         visited.emplace_back(false);
         size++;
     }
@@ -72,6 +78,17 @@ public:
         }
     }
 
+    /**
+     * removes every vertex and edge from the graph while keeping the memory already reserved for them. the edge list of
+     * every vertex is kept as well and reused by add_vertex, so a graph that is rebuilt over and over again (e.g. by a
+     * long-running server) does not reallocate any of its storage.
+     */
+    void clear() {
+        vertices.clear();
+        visited.clear();
+        size = 0;
+    }
+
     /* GETTERS */
     /**
      * return the vertex value at index i
@@ -101,7 +118,7 @@ public:
      * @param i the index of a vertex
      * @return the indexes of edge connections at vertex i
      */
-    std::vector<int> get_edges(const int i) {
+    [[nodiscard]] const std::vector<int> &get_edges(const int i) const {
         if (validate_index(i)) {
             return edges[i];
         }
@@ -114,6 +131,40 @@ public:
         return size;
     }
 
+    /* SEARCHES */
+    /**
+     * a breadth first search from the vertex at index root. order doubles as the queue of the search: vertices are
+     * appended to it as they are reached and expanded in that order, so every vertex is visited once and every
+     * connection is looked at twice. in a graph with cycles a vertex can be reached from several vertices, its parent is
+     * always the first of them in order, so the result only depends on the graph and the order of its edges.
+     * @param root the index of the vertex to start from
+     * @param depth filled with the number of edges between root and each vertex, -1 for vertices that can't be reached
+     * @param parent filled with the index of the vertex each vertex was reached from, -1 for root and unreached vertices
+     * @param order filled with the indexes of all reached vertices in the order they were visited, level by level
+     */
+    void breadth_first_search(const int root, std::vector<int> &depth, std::vector<int> &parent, std::vector<int> &order) const {
+        if (!validate_index(root)) {
+            throw std::invalid_argument("ERROR in Adjacency_List::breadth_first_search: index out of range");
+        }
+        depth.assign(size, -1);
+        parent.assign(size, -1);
+        order.clear();
+        order.reserve(size);
+
+        depth[root] = 0;
+        order.push_back(root);
+        for (std::size_t next = 0; next < order.size(); next++) {
+            const int current = order[next];
+            for (const int neighbour : edges[current]) {
+                if (depth[neighbour] == -1) {
+                    depth[neighbour] = depth[current] + 1;
+                    parent[neighbour] = current;
+                    order.push_back(neighbour);
+                }
+            }
+        }
+    }
+
     /* SUBTRACTIVE MANIPULATORS */
     /**
      * removes the vertex at index i and all of its edged, then returns its value
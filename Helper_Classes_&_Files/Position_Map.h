@@ -0,0 +1,144 @@
+//
+// Created by aowyn on 10/20/26.
+//
+
+#ifndef RDG_UNLIMITED_POSITION_MAP_H
+#define RDG_UNLIMITED_POSITION_MAP_H
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/**
+ * A flat hash map from cartesian points to non-negative integers, used to look up which tile is placed at a position.
+ * entries live in a single vector using open addressing with linear probing, and the index of every occupied slot is
+ * recorded, so clearing the map only empties the slots that are in use and keeps all of its memory. a map that is
+ * cleared and refilled over and over again (e.g. by a long-running server) therefore never reallocates once it has
+ * grown to the largest size it is used for, and clearing costs the same no matter how large it once grew.
+ * ATTRIBUTES:
+ * @var slots, the table of entries, its size is always zero or a power of two
+ * @var shift, 64 minus the base 2 logarithm of the size of slots, used to turn a hash into a slot index
+ * @var occupied, the index in slots of every entry in the map, its size is the number of entries
+ */
+class Position_Map {
+private:
+    /**
+     * @struct slot holds one entry of the table, a value of -1 marks the slot as empty.
+     */
+    struct slot {
+        std::pair<int, int> position;
+        int value = -1;
+    };
+
+    std::vector<slot> slots;
+    int shift = 64;
+    std::vector<std::size_t> occupied;
+
+    /**
+     * returns the index of the slot that holds position, or of the empty slot where it would be inserted
+     */
+    [[nodiscard]] std::size_t probe(const std::pair<int, int> &position) const {
+        const std::uint64_t key = static_cast<std::uint64_t>(static_cast<std::uint32_t>(position.first)) << 32 |
+                                  static_cast<std::uint32_t>(position.second);
+        //fibonacci hashing, the top bits of the product spread neighbouring positions over the table
+        std::size_t index = (key * 0x9E3779B97F4A7C15ull) >> shift;
+        while (slots[index].value != -1 && slots[index].position != position) {
+            index = (index + 1) & (slots.size() - 1);
+        }
+        return index;
+    }
+
+    /**
+     * grows the table to capacity slots, capacity must be a power of two, and reinserts every entry, recording the slots
+     * they end up in
+     */
+    void rehash(const std::size_t capacity) {
+        std::vector<slot> old(capacity);
+        old.swap(slots);
+        shift = 64;
+        for (std::size_t i = capacity; i > 1; i /= 2) {
+            shift--;
+        }
+        for (auto &index : occupied) {
+            const slot entry = old[index];
+            index = probe(entry.position);
+            slots[index] = entry;
+        }
+    }
+public:
+    /* ADDITIVE MANIPULATORS */
+    /**
+     * makes room for at least n entries without growing the table again
+     * @param n the number of entries
+     */
+    void reserve(const std::size_t n) {
+        std::size_t capacity = slots.empty() ? 16 : slots.size();
+        while (capacity < 2 * n) {
+            capacity *= 2;
+        }
+        if (capacity != slots.size()) {
+            rehash(capacity);
+        }
+    }
+
+    /**
+     * maps position to value if position is not in the map yet
+     * @param position the cartesian point to add
+     * @param value the non-negative value stored for position
+     */
+    void emplace(const std::pair<int, int> &position, const int value) {
+        if (value < 0) {
+            throw std::invalid_argument("ERROR in Position_Map::emplace: value must not be negative");
+        }
+        reserve(occupied.size() + 1);
+        const std::size_t index = probe(position);
+        if (slots[index].value == -1) {
+            slots[index] = {position, value};
+            occupied.push_back(index);
+        }
+    }
+
+    /* GETTERS */
+    /**
+     * return the value stored for position
+     * @param position a cartesian point
+     * @return the value of position, or -1 if position is not in the map
+     */
+    [[nodiscard]] int find(const std::pair<int, int> &position) const {
+        return slots.empty() ? -1 : slots[probe(position)].value;
+    }
+
+    [[nodiscard]] bool contains(const std::pair<int, int> &position) const {
+        return find(position) != -1;
+    }
+
+    /**
+     * return the value stored for position
+     * @param position a cartesian point that is in the map
+     * @return the value of position
+     */
+    [[nodiscard]] int at(const std::pair<int, int> &position) const {
+        const int value = find(position);
+        if (value == -1) {
+            throw std::invalid_argument("ERROR in Position_Map::at: position not in map");
+        }
+        return value;
+    }
+
+    [[nodiscard]] std::size_t size() const {
+        return occupied.size();
+    }
+
+    /* SUBTRACTIVE MANIPULATORS */
+    /**
+     * removes every entry while keeping the table at its current size, only the occupied slots are touched
+     */
+    void clear() {
+        for (const std::size_t index : occupied) {
+            slots[index].value = -1;
+        }
+        occupied.clear();
+    }
+};
+
+#endif //RDG_UNLIMITED_POSITION_MAP_H
@@ -2,12 +2,93 @@
 // Created by aowynbb on 09/06/25.
 //
 
+#include <algorithm>
+#include <charconv>
+#include <csignal>
+#include <cstring>
 #include <iostream>
+#include <string>
+#include <thread>
 
 #include "Dungeon_Map/Dungeon_Map.h"
+#include "Dungeon_Server/Dungeon_Server.h"
 
-int main()
+//the running server, used by the signal handler to shut it down cleanly
+static Dungeon_Server *active_server = nullptr;
+
+static void stop_server(int) {
+    if (active_server != nullptr) {
+        active_server->stop();
+    }
+}
+
+static int print_usage(const char *program) {
+    std::cerr << "usage: " << program << " [--serve <socket> [workers] | --request <socket> <size> <seed> <format> | "
+              << "--request <socket> stats]" << std::endl;
+    return 1;
+}
+
+/**
+ * Usage:
+ *      RDG_Unlimited                                           generate a 2000 tile dungeon into Dungeon_Map.svg
+ *      RDG_Unlimited --serve <socket> [workers]                run the generator server on a Unix domain socket
+ *      RDG_Unlimited --request <socket> <size> <seed> <format> request a dungeon from a running server
+ *      RDG_Unlimited --request <socket> stats                  request the latency metrics of a running server
+ */
+int main(const int argc, char *argv[])
 {
+    const std::string mode = argc > 1 ? argv[1] : "";
+
+    if (mode == "--serve" && (argc == 3 || argc == 4)) {
+        //more workers than a few per core only add threads that wait for a turn on the cpu
+        const int cores = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        const int max_workers = 4 * cores;
+        int workers = cores;
+        if (argc == 4) {
+            const char *end = argv[3] + std::strlen(argv[3]);
+            const auto [last, error] = std::from_chars(argv[3], end, workers);
+            if (error != std::errc() || last != end || workers < 1) {
+                std::cerr << "ERROR: workers must be a positive integer, got \"" << argv[3] << "\"" << std::endl;
+                return print_usage(argv[0]);
+            }
+            if (workers > max_workers) {
+                std::cerr << "limiting workers to " << max_workers << " (4 per core)" << std::endl;
+                workers = max_workers;
+            }
+        }
+        Dungeon_Server server(argv[2], workers);
+        active_server = &server;
+        std::signal(SIGINT, stop_server);
+        std::signal(SIGTERM, stop_server);
+        try {
+            server.run();
+        }
+        catch (const std::exception &e) {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+        active_server = nullptr;
+        return 0;
+    }
+
+    if (mode == "--request" && (argc == 4 || argc == 6)) {
+        const std::string request_line = argc == 4
+            ? std::string(argv[3])
+            : std::string(argv[3]) + " " + argv[4] + " " + argv[5];
+        try {
+            request_dungeon(argv[2], request_line, std::cout);
+        }
+        catch (const std::exception &e) {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    if (!mode.empty()) {
+        return print_usage(argv[0]);
+    }
+
     std::random_device random;
     std::mt19937 generator(random());
     Dungeon_Map map(2000);